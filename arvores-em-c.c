@@ -1,11 +1,33 @@
+#ifdef __linux__
+#define _POSIX_C_SOURCE 200809L
+#endif
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef __linux__
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdint.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
 
 // Estrutura para nó de Árvore de Busca Binária (BST)
 typedef struct NoBST {
     int valor;
     struct NoBST* esquerda;
     struct NoBST* direita;
+    int removido;  // 1 se o nó foi marcado como removido (remoção preguiçosa)
+    int pendente;  // 1 se o valor está na lista de remoções pendentes
 } NoBST;
 
 // Estrutura para nó de Árvore AVL
@@ -14,6 +36,8 @@ typedef struct NoAVL {
     struct NoAVL* esquerda;
     struct NoAVL* direita;
     int altura;
+    int removido;  // 1 se o nó foi marcado como removido (remoção preguiçosa)
+    int pendente;  // 1 se o valor está na lista de remoções pendentes
 } NoAVL;
 
 // Estrutura para nó de Árvore 2-3-4
@@ -23,6 +47,37 @@ typedef struct No234 {
     int numChaves;  // Número atual de chaves
 } No234;
 
+// Percentual de nós removidos a partir do qual a compactação é recomendada
+#define LIMIAR_COMPACTACAO 25
+// Máximo de remoções físicas realizadas em cada etapa de compactação
+#define FATIA_COMPACTACAO 8
+
+// Controle da remoção preguiçosa (compartilhado pelas árvores BST e AVL)
+typedef struct ControleRemocao {
+    int* pendentes;     // Valores marcados, aguardando remoção física (sem repetições)
+    int numPendentes;
+    int capacidade;
+    int numNos;         // Nós fisicamente presentes na árvore
+    int numRemovidos;   // Nós marcados como removidos
+} ControleRemocao;
+
+// Número de posições do cache de chaves quentes (potência de 2)
+#define TAMANHO_CACHE 4096
+
+// Estados de uma posição do cache
+#define CACHE_VAZIA 0
+#define CACHE_OCUPADA 1
+#define CACHE_REFERENCIADA 2  // Teve acerto desde a última tentativa de substituição
+
+// Cache de chaves quentes, consultado antes da árvore. Guarda apenas chaves
+// sabidamente presentes, por isso só precisa ser invalidado nas remoções.
+typedef struct CacheQuente {
+    int chaves[TAMANHO_CACHE];
+    unsigned char estado[TAMANHO_CACHE];
+    long acertos;
+    long falhas;
+} CacheQuente;
+
 // ======== FUNÇÕES PARA ÁRVORE BST ========
 
 // Criar um novo nó para BST
@@ -35,6 +90,8 @@ NoBST* criarNoBST(int valor) {
     novoNo->valor = valor;
     novoNo->esquerda = NULL;
     novoNo->direita = NULL;
+    novoNo->removido = 0;
+    novoNo->pendente = 0;
     return novoNo;
 }
 
@@ -48,15 +105,22 @@ NoBST* inserirBST(NoBST* raiz, int valor) {
         raiz->esquerda = inserirBST(raiz->esquerda, valor);
     } else if (valor > raiz->valor) {
         raiz->direita = inserirBST(raiz->direita, valor);
+    } else {
+        // Reinserir um valor marcado como removido apenas o reativa
+        raiz->removido = 0;
     }
     
     return raiz;
 }
 
-// Buscar valor na BST
+// Buscar valor na BST (nós marcados como removidos são ignorados)
 NoBST* buscarBST(NoBST* raiz, int valor) {
-    if (raiz == NULL || raiz->valor == valor) {
-        return raiz;
+    if (raiz == NULL) {
+        return NULL;
+    }
+    
+    if (raiz->valor == valor) {
+        return raiz->removido ? NULL : raiz;
     }
     
     if (valor < raiz->valor) {
@@ -100,6 +164,8 @@ NoBST* removerBST(NoBST* raiz, int valor) {
         // Nó com dois filhos
         NoBST* temp = encontrarMinimoBST(raiz->direita);
         raiz->valor = temp->valor;
+        raiz->removido = temp->removido;
+        raiz->pendente = temp->pendente;
         raiz->direita = removerBST(raiz->direita, temp->valor);
     }
     
@@ -110,7 +176,9 @@ NoBST* removerBST(NoBST* raiz, int valor) {
 void percorrerInordemBST(NoBST* raiz) {
     if (raiz != NULL) {
         percorrerInordemBST(raiz->esquerda);
-        printf("%d ", raiz->valor);
+        if (!raiz->removido) {
+            printf("%d ", raiz->valor);
+        }
         percorrerInordemBST(raiz->direita);
     }
 }
@@ -127,7 +195,7 @@ void exibirBST(NoBST* raiz, int nivel) {
         printf("    ");
     }
     
-    printf("%d\n", raiz->valor);
+    printf("%d%s\n", raiz->valor, raiz->removido ? " (removido)" : "");
     
     exibirBST(raiz->esquerda, nivel + 1);
 }
@@ -167,6 +235,8 @@ NoAVL* criarNoAVL(int valor) {
     no->esquerda = NULL;
     no->direita = NULL;
     no->altura = 1;  // Novo nó é inicialmente inserido como folha
+    no->removido = 0;
+    no->pendente = 0;
     return no;
 }
 
@@ -222,7 +292,9 @@ NoAVL* inserirAVL(NoAVL* no, int valor) {
     } else if (valor > no->valor) {
         no->direita = inserirAVL(no->direita, valor);
     } else {
-        // Valores duplicados não são permitidos
+        // Valores duplicados não são permitidos; um valor marcado como
+        // removido é apenas reativado
+        no->removido = 0;
         return no;
     }
     
@@ -269,6 +341,18 @@ NoAVL* encontrarMinimoAVL(NoAVL* no) {
     return atual;
 }
 
+// Buscar valor na árvore AVL (nós marcados como removidos são ignorados)
+NoAVL* buscarAVL(NoAVL* raiz, int valor) {
+    NoAVL* atual = raiz;
+    while (atual != NULL && atual->valor != valor) {
+        atual = (valor < atual->valor) ? atual->esquerda : atual->direita;
+    }
+    if (atual != NULL && atual->removido) {
+        return NULL;
+    }
+    return atual;
+}
+
 // Remover nó da árvore AVL
 NoAVL* removerAVL(NoAVL* raiz, int valor) {
     // Passo 1: Remoção BST padrão
@@ -299,6 +383,8 @@ NoAVL* removerAVL(NoAVL* raiz, int valor) {
             // Nó com dois filhos
             NoAVL* temp = encontrarMinimoAVL(raiz->direita);
             raiz->valor = temp->valor;
+            raiz->removido = temp->removido;
+            raiz->pendente = temp->pendente;
             raiz->direita = removerAVL(raiz->direita, temp->valor);
         }
     }
@@ -353,7 +439,8 @@ void exibirAVL(NoAVL* raiz, int nivel) {
         printf("    ");
     }
     
-    printf("%d (h=%d)\n", raiz->valor, raiz->altura);
+    printf("%d (h=%d)%s\n", raiz->valor, raiz->altura,
+           raiz->removido ? " (removido)" : "");
     
     exibirAVL(raiz->esquerda, nivel + 1);
 }
@@ -367,6 +454,208 @@ void liberarAVL(NoAVL* raiz) {
     }
 }
 
+// ======== REMOÇÃO PREGUIÇOSA (BST E AVL) ========
+
+// Inicializar controle de remoção preguiçosa
+void iniciarControleRemocao(ControleRemocao* controle) {
+    controle->pendentes = NULL;
+    controle->numPendentes = 0;
+    controle->capacidade = 0;
+    controle->numNos = 0;
+    controle->numRemovidos = 0;
+}
+
+// Liberar memória do controle de remoção preguiçosa
+void liberarControleRemocao(ControleRemocao* controle) {
+    free(controle->pendentes);
+    iniciarControleRemocao(controle);
+}
+
+// Registrar valor marcado para remoção física posterior
+void adicionarPendente(ControleRemocao* controle, int valor) {
+    if (controle->numPendentes == controle->capacidade) {
+        int novaCapacidade = controle->capacidade ? controle->capacidade * 2 : 64;
+        int* novos = (int*)realloc(controle->pendentes, novaCapacidade * sizeof(int));
+        if (novos == NULL) {
+            fprintf(stderr, "Erro na alocação de memória\n");
+            exit(EXIT_FAILURE);
+        }
+        controle->pendentes = novos;
+        controle->capacidade = novaCapacidade;
+    }
+    controle->pendentes[controle->numPendentes++] = valor;
+}
+
+// Verificar se a proporção de nós removidos ultrapassou o limiar
+int deveCompactar(ControleRemocao* controle) {
+    return controle->numRemovidos > 0 &&
+           (long long)controle->numRemovidos * 100 >= (long long)controle->numNos * LIMIAR_COMPACTACAO;
+}
+
+// Localizar nó na BST, inclusive se estiver marcado como removido
+NoBST* localizarBST(NoBST* raiz, int valor) {
+    NoBST* atual = raiz;
+    while (atual != NULL && atual->valor != valor) {
+        atual = (valor < atual->valor) ? atual->esquerda : atual->direita;
+    }
+    return atual;
+}
+
+// Inserir valor na BST mantendo o controle de remoção atualizado
+NoBST* inserirBSTControlado(NoBST* raiz, int valor, ControleRemocao* controle) {
+    NoBST* no = localizarBST(raiz, valor);
+    if (no == NULL) {
+        controle->numNos++;
+        return inserirBST(raiz, valor);
+    }
+    if (no->removido) {
+        no->removido = 0;
+        controle->numRemovidos--;
+    }
+    return raiz;
+}
+
+// Remover valor da BST imediatamente, mantendo o controle atualizado
+NoBST* removerBSTControlado(NoBST* raiz, int valor, ControleRemocao* controle) {
+    NoBST* no = localizarBST(raiz, valor);
+    if (no == NULL) {
+        return raiz;
+    }
+    
+    // Um valor já presente na lista de pendentes é apenas marcado; a
+    // compactação o remove depois, sem deixar entradas órfãs na lista
+    if (no->pendente) {
+        if (!no->removido) {
+            no->removido = 1;
+            controle->numRemovidos++;
+        }
+        return raiz;
+    }
+    
+    controle->numNos--;
+    return removerBST(raiz, valor);
+}
+
+// Remover fisicamente até 'limite' nós marcados da BST
+NoBST* compactarBST(NoBST* raiz, ControleRemocao* controle, int limite) {
+    while (limite > 0 && controle->numPendentes > 0) {
+        int valor = controle->pendentes[--controle->numPendentes];
+        NoBST* no = localizarBST(raiz, valor);
+        
+        if (no == NULL) {
+            continue;
+        }
+        no->pendente = 0;
+        
+        // O valor pode ter sido reinserido depois da marcação
+        if (no->removido) {
+            controle->numRemovidos--;
+            controle->numNos--;
+            raiz = removerBST(raiz, valor);
+            limite--;
+        }
+    }
+    return raiz;
+}
+
+// Marcar valor como removido na BST, sem reestruturar a árvore; retorna 1 se o valor
+// estava presente. A remoção física fica para compactarBST.
+int removerPreguicosoBST(NoBST* raiz, int valor, ControleRemocao* controle) {
+    NoBST* no = localizarBST(raiz, valor);
+    if (no == NULL || no->removido) {
+        return 0;
+    }
+    no->removido = 1;
+    controle->numRemovidos++;
+    if (!no->pendente) {
+        no->pendente = 1;
+        adicionarPendente(controle, valor);
+    }
+    return 1;
+}
+
+// Localizar nó na árvore AVL, inclusive se estiver marcado como removido
+NoAVL* localizarAVL(NoAVL* raiz, int valor) {
+    NoAVL* atual = raiz;
+    while (atual != NULL && atual->valor != valor) {
+        atual = (valor < atual->valor) ? atual->esquerda : atual->direita;
+    }
+    return atual;
+}
+
+// Inserir valor na árvore AVL mantendo o controle de remoção atualizado
+NoAVL* inserirAVLControlado(NoAVL* raiz, int valor, ControleRemocao* controle) {
+    NoAVL* no = localizarAVL(raiz, valor);
+    if (no == NULL) {
+        controle->numNos++;
+        return inserirAVL(raiz, valor);
+    }
+    if (no->removido) {
+        no->removido = 0;
+        controle->numRemovidos--;
+    }
+    return raiz;
+}
+
+// Remover valor da árvore AVL imediatamente, mantendo o controle atualizado
+NoAVL* removerAVLControlado(NoAVL* raiz, int valor, ControleRemocao* controle) {
+    NoAVL* no = localizarAVL(raiz, valor);
+    if (no == NULL) {
+        return raiz;
+    }
+    
+    // Um valor já presente na lista de pendentes é apenas marcado; a
+    // compactação o remove depois, sem deixar entradas órfãs na lista
+    if (no->pendente) {
+        if (!no->removido) {
+            no->removido = 1;
+            controle->numRemovidos++;
+        }
+        return raiz;
+    }
+    
+    controle->numNos--;
+    return removerAVL(raiz, valor);
+}
+
+// Remover fisicamente até 'limite' nós marcados da árvore AVL
+NoAVL* compactarAVL(NoAVL* raiz, ControleRemocao* controle, int limite) {
+    while (limite > 0 && controle->numPendentes > 0) {
+        int valor = controle->pendentes[--controle->numPendentes];
+        NoAVL* no = localizarAVL(raiz, valor);
+        
+        if (no == NULL) {
+            continue;
+        }
+        no->pendente = 0;
+        
+        // O valor pode ter sido reinserido depois da marcação
+        if (no->removido) {
+            controle->numRemovidos--;
+            controle->numNos--;
+            raiz = removerAVL(raiz, valor);
+            limite--;
+        }
+    }
+    return raiz;
+}
+
+// Marcar valor como removido na árvore AVL, sem rotações; retorna 1 se o valor
+// estava presente. A remoção física fica para compactarAVL.
+int removerPreguicosoAVL(NoAVL* raiz, int valor, ControleRemocao* controle) {
+    NoAVL* no = localizarAVL(raiz, valor);
+    if (no == NULL || no->removido) {
+        return 0;
+    }
+    no->removido = 1;
+    controle->numRemovidos++;
+    if (!no->pendente) {
+        no->pendente = 1;
+        adicionarPendente(controle, valor);
+    }
+    return 1;
+}
+
 // ======== FUNÇÕES PARA ÁRVORE 2-3-4 ========
 
 // Criar novo nó para árvore 2-3-4
@@ -440,8 +729,11 @@ void inserirEmNoNaoCheio(No234* no, int chave) {
             No234* y = no->filhos[i];
             No234* z = criarNo234();
             
-            // Mover a chave do meio do filho para o nó atual
-            no->chaves[no->numChaves] = y->chaves[1];
+            // Mover a chave do meio do filho para o nó atual, na posição i
+            for (int j = no->numChaves; j > i; j--) {
+                no->chaves[j] = no->chaves[j-1];
+            }
+            no->chaves[i] = y->chaves[1];
             no->numChaves++;
             
             // Configurar o novo nó z
@@ -564,81 +856,1601 @@ void liberar234(No234* raiz) {
     free(raiz);
 }
 
-// ======== FUNÇÃO MAIN ========
+// ======== CACHE DE CHAVES QUENTES ========
 
-int main() {
-    int escolha, valor;
-    NoBST* raizBST = NULL;
-    NoAVL* raizAVL = NULL;
-    No234* raiz234 = NULL;
+// Inicializar cache vazio
+void iniciarCache(CacheQuente* cache) {
+    memset(cache->estado, CACHE_VAZIA, sizeof(cache->estado));
+    cache->acertos = 0;
+    cache->falhas = 0;
+}
+
+// Calcular posição da chave no cache (hash multiplicativo)
+int posicaoCache(int chave) {
+    return (int)(((unsigned int)chave * 2654435761u) >> 16) & (TAMANHO_CACHE - 1);
+}
+
+// Consultar cache; retorna 1 se a chave está presente
+int consultarCache(CacheQuente* cache, int chave) {
+    int pos = posicaoCache(chave);
+    if (cache->estado[pos] != CACHE_VAZIA && cache->chaves[pos] == chave) {
+        cache->estado[pos] = CACHE_REFERENCIADA;
+        cache->acertos++;
+        return 1;
+    }
+    cache->falhas++;
+    return 0;
+}
+
+// Registrar chave encontrada na árvore. Uma chave referenciada ganha uma
+// segunda chance antes de ser substituída, o que protege as chaves quentes
+// de serem expulsas por chaves acessadas uma única vez.
+void registrarCache(CacheQuente* cache, int chave) {
+    int pos = posicaoCache(chave);
+    if (cache->estado[pos] == CACHE_REFERENCIADA) {
+        cache->estado[pos] = CACHE_OCUPADA;
+        return;
+    }
+    cache->chaves[pos] = chave;
+    cache->estado[pos] = CACHE_OCUPADA;
+}
+
+// Invalidar chave removida da árvore
+void invalidarCache(CacheQuente* cache, int chave) {
+    int pos = posicaoCache(chave);
+    if (cache->estado[pos] != CACHE_VAZIA && cache->chaves[pos] == chave) {
+        cache->estado[pos] = CACHE_VAZIA;
+    }
+}
+
+// Taxa de acertos do cache, em percentual
+double taxaAcertosCache(CacheQuente* cache) {
+    long total = cache->acertos + cache->falhas;
+    return total > 0 ? 100.0 * cache->acertos / total : 0.0;
+}
+
+// Exibir estatísticas do cache
+void exibirEstatisticasCache(CacheQuente* cache) {
+    printf("Acertos: %ld, falhas: %ld, taxa de acertos: %.2f%%\n",
+           cache->acertos, cache->falhas, taxaAcertosCache(cache));
+}
+
+// Buscar valor na BST passando antes pelo cache
+int buscarBSTComCache(CacheQuente* cache, NoBST* raiz, int valor) {
+    if (consultarCache(cache, valor)) {
+        return 1;
+    }
+    if (buscarBST(raiz, valor) == NULL) {
+        return 0;
+    }
+    registrarCache(cache, valor);
+    return 1;
+}
+
+// Buscar valor na árvore AVL passando antes pelo cache
+int buscarAVLComCache(CacheQuente* cache, NoAVL* raiz, int valor) {
+    if (consultarCache(cache, valor)) {
+        return 1;
+    }
+    if (buscarAVL(raiz, valor) == NULL) {
+        return 0;
+    }
+    registrarCache(cache, valor);
+    return 1;
+}
+
+// Buscar chave na árvore 2-3-4 passando antes pelo cache
+int buscar234ComCache(CacheQuente* cache, No234* raiz, int chave) {
+    No234* noEncontrado = NULL;
+    int posicao = -1;
+    
+    if (consultarCache(cache, chave)) {
+        return 1;
+    }
+    if (!buscar234(raiz, chave, &noEncontrado, &posicao)) {
+        return 0;
+    }
+    registrarCache(cache, chave);
+    return 1;
+}
+
+// ======== EXPORTAÇÃO ITERATIVA (TEXTO, DOT E JSON) ========
+
+#define FORMATO_TEXTO 0
+#define FORMATO_DOT 1
+#define FORMATO_JSON 2
+
+// Tamanho do buffer de saída usado na exportação
+#define TAMANHO_BUFFER_SAIDA (1 << 16)
+
+// Opções de exportação
+typedef struct OpcoesExportacao {
+    int formato;          // FORMATO_TEXTO, FORMATO_DOT ou FORMATO_JSON
+    int profundidadeMax;  // Profundidade máxima exportada (-1 para sem limite)
+    int chaveMin;         // Apenas chaves no intervalo [chaveMin, chaveMax]
+    int chaveMax;
+} OpcoesExportacao;
+
+// Estado de uma exportação em andamento
+typedef struct Exportador {
+    FILE* arquivo;
+    OpcoesExportacao opcoes;
+    int proximoId;        // Próximo identificador livre
+    int numEscritos;      // Nós já escritos
+    size_t usado;         // Bytes ocupados no buffer
+    char buffer[TAMANHO_BUFFER_SAIDA];
+} Exportador;
+
+// Item da pilha usada para percorrer as árvores sem recursão
+typedef struct ItemPilha {
+    void* no;
+    int profundidade;
+    int id;               // Identificador do nó (igual a idPai se não for exportado)
+    int idPai;            // Identificador do ancestral exportado mais próximo (-1 se nenhum)
+} ItemPilha;
+
+// Pilha dinâmica de percurso
+typedef struct PilhaPercurso {
+    ItemPilha* itens;
+    int tamanho;
+    int capacidade;
+} PilhaPercurso;
+
+// Opções padrão: texto, sem limite de profundidade ou de chaves
+OpcoesExportacao opcoesExportacaoPadrao() {
+    OpcoesExportacao opcoes;
+    opcoes.formato = FORMATO_TEXTO;
+    opcoes.profundidadeMax = -1;
+    opcoes.chaveMin = INT_MIN;
+    opcoes.chaveMax = INT_MAX;
+    return opcoes;
+}
+
+// Empilhar item na pilha de percurso
+void empilhar(PilhaPercurso* pilha, void* no, int profundidade, int id, int idPai) {
+    if (pilha->tamanho == pilha->capacidade) {
+        int novaCapacidade = pilha->capacidade ? pilha->capacidade * 2 : 64;
+        ItemPilha* novos = (ItemPilha*)realloc(pilha->itens, novaCapacidade * sizeof(ItemPilha));
+        if (novos == NULL) {
+            fprintf(stderr, "Erro na alocação de memória\n");
+            exit(EXIT_FAILURE);
+        }
+        pilha->itens = novos;
+        pilha->capacidade = novaCapacidade;
+    }
+    pilha->itens[pilha->tamanho].no = no;
+    pilha->itens[pilha->tamanho].profundidade = profundidade;
+    pilha->itens[pilha->tamanho].id = id;
+    pilha->itens[pilha->tamanho].idPai = idPai;
+    pilha->tamanho++;
+}
+
+// Verificar se a profundidade está dentro do limite de exportação
+int dentroDaProfundidade(Exportador* exp, int profundidade) {
+    return exp->opcoes.profundidadeMax < 0 || profundidade <= exp->opcoes.profundidadeMax;
+}
+
+// Verificar se a chave está dentro do intervalo de exportação
+int dentroDoIntervalo(Exportador* exp, int chave) {
+    return chave >= exp->opcoes.chaveMin && chave <= exp->opcoes.chaveMax;
+}
+
+// Gravar o conteúdo do buffer no arquivo
+void descarregarBuffer(Exportador* exp) {
+    if (exp->usado > 0) {
+        fwrite(exp->buffer, 1, exp->usado, exp->arquivo);
+        exp->usado = 0;
+    }
+}
+
+// Escrever texto no buffer de saída
+void escreverTexto(Exportador* exp, const char* texto) {
+    size_t tamanho = strlen(texto);
+    if (exp->usado + tamanho > TAMANHO_BUFFER_SAIDA) {
+        descarregarBuffer(exp);
+    }
+    memcpy(exp->buffer + exp->usado, texto, tamanho);
+    exp->usado += tamanho;
+}
+
+// Escrever inteiro no buffer de saída, sem passar pelo printf
+void escreverInteiro(Exportador* exp, int numero) {
+    char digitos[12];
+    int pos = sizeof(digitos) - 1;
+    unsigned int absoluto = (numero < 0) ? 0u - (unsigned int)numero : (unsigned int)numero;
     
+    digitos[pos] = '\0';
     do {
-        printf("\n==== MENU DE OPERACOES COM ARVORES ====\n");
-        printf("1. Arvore de Busca Binaria (BST)\n");
-        printf("2. Arvore AVL\n");
-        printf("3. Arvore 2-3-4\n");
-        printf("0. Sair\n");
-        printf("Escolha uma opcao: ");
-        scanf("%d", &escolha);
-        
-        switch (escolha) {
-            case 1: // BST
-                do {
-                    printf("\n--- Operacoes com BST ---\n");
-                    printf("1. Inserir valor\n");
-                    printf("2. Buscar valor\n");
-                    printf("3. Remover valor\n");
-                    printf("4. Exibir arvore\n");
-                    printf("0. Voltar\n");
-                    printf("Escolha uma opcao: ");
-                    scanf("%d", &escolha);
-                    
-                    switch (escolha) {
-                        case 1:
-                            printf("Digite o valor a inserir: ");
-                            scanf("%d", &valor);
-                            raizBST = inserirBST(raizBST, valor);
-                            printf("Valor %d inserido com sucesso!\n", valor);
-                            break;
-                        case 2:
-                            printf("Digite o valor a buscar: ");
-                            scanf("%d", &valor);
-                            if (buscarBST(raizBST, valor) != NULL) {
-                                printf("Valor %d encontrado na arvore!\n", valor);
-                            } else {
-                                printf("Valor %d não encontrado na arvore.\n", valor);
-                            }
-                            break;
-                        case 3:
-                            printf("Digite o valor a remover: ");
-                            scanf("%d", &valor);
-                            raizBST = removerBST(raizBST, valor);
-                            printf("Operacao de remocao concluida.\n");
-                            break;
-                        case 4:
-                            printf("\nExibicao da BST:\n");
-                            if (raizBST == NULL) {
-                                printf("Arvore vazia\n");
-                            } else {
-                                exibirBST(raizBST, 0);
-                            }
-                            break;
-                        case 0:
-                            break;
-                        default:
-                            printf("Opcao invalida!\n");
-                    }
-                } while (escolha != 0);
-                escolha = -1; // Retorna ao menu principal
+        digitos[--pos] = (char)('0' + absoluto % 10);
+        absoluto /= 10;
+    } while (absoluto > 0);
+    
+    if (numero < 0) {
+        digitos[--pos] = '-';
+    }
+    escreverTexto(exp, digitos + pos);
+}
+
+// Escrever o início da exportação
+void iniciarExportacao(Exportador* exp, const char* nomeArvore) {
+    if (exp->opcoes.formato == FORMATO_DOT) {
+        escreverTexto(exp, "digraph ");
+        escreverTexto(exp, nomeArvore);
+        escreverTexto(exp, " {\n");
+    } else if (exp->opcoes.formato == FORMATO_JSON) {
+        escreverTexto(exp, "{\"arvore\": \"");
+        escreverTexto(exp, nomeArvore);
+        escreverTexto(exp, "\", \"nos\": [");
+    }
+}
+
+// Escrever o fim da exportação e descarregar o buffer
+void finalizarExportacao(Exportador* exp) {
+    if (exp->opcoes.formato == FORMATO_DOT) {
+        escreverTexto(exp, "}\n");
+    } else if (exp->opcoes.formato == FORMATO_JSON) {
+        escreverTexto(exp, "\n]}\n");
+    }
+    descarregarBuffer(exp);
+    fflush(exp->arquivo);
+}
+
+// Escrever o início de um nó
+void iniciarNoExportado(Exportador* exp, int id, int profundidade, int idPai) {
+    if (exp->opcoes.formato == FORMATO_TEXTO) {
+        for (int i = 0; i < profundidade; i++) {
+            escreverTexto(exp, "    ");
+        }
+    } else if (exp->opcoes.formato == FORMATO_DOT) {
+        escreverTexto(exp, "    n");
+        escreverInteiro(exp, id);
+        escreverTexto(exp, " [label=\"");
+    } else {
+        escreverTexto(exp, exp->numEscritos == 0 ? "\n    {\"id\": " : ",\n    {\"id\": ");
+        escreverInteiro(exp, id);
+        escreverTexto(exp, ", \"pai\": ");
+        if (idPai < 0) {
+            escreverTexto(exp, "null");
+        } else {
+            escreverInteiro(exp, idPai);
+        }
+        escreverTexto(exp, ", \"profundidade\": ");
+        escreverInteiro(exp, profundidade);
+        escreverTexto(exp, ", ");
+    }
+    exp->numEscritos++;
+}
+
+// Escrever o fim de um nó (e a aresta para o pai no formato DOT)
+void finalizarNoExportado(Exportador* exp, int id, int idPai) {
+    if (exp->opcoes.formato == FORMATO_TEXTO) {
+        escreverTexto(exp, "\n");
+    } else if (exp->opcoes.formato == FORMATO_DOT) {
+        escreverTexto(exp, "\"];\n");
+        if (idPai >= 0) {
+            escreverTexto(exp, "    n");
+            escreverInteiro(exp, idPai);
+            escreverTexto(exp, " -> n");
+            escreverInteiro(exp, id);
+            escreverTexto(exp, ";\n");
+        }
+    } else {
+        escreverTexto(exp, "}");
+    }
+}
+
+// Criar exportador para o arquivo informado
+Exportador* criarExportador(FILE* arquivo, OpcoesExportacao opcoes) {
+    Exportador* exp = (Exportador*)malloc(sizeof(Exportador));
+    if (exp == NULL) {
+        fprintf(stderr, "Erro na alocação de memória\n");
+        exit(EXIT_FAILURE);
+    }
+    exp->arquivo = arquivo;
+    exp->opcoes = opcoes;
+    exp->proximoId = 0;
+    exp->numEscritos = 0;
+    exp->usado = 0;
+    return exp;
+}
+
+// Exportar BST sem recursão, na mesma ordem visual de exibirBST
+void exportarBST(FILE* arquivo, NoBST* raiz, OpcoesExportacao opcoes) {
+    Exportador* exp = criarExportador(arquivo, opcoes);
+    PilhaPercurso pilha = {NULL, 0, 0};
+    NoBST* atual = raiz;
+    int profundidade = 0;
+    int idPai = -1;
+    
+    iniciarExportacao(exp, "BST");
+    
+    // Percurso em ordem invertida (direita, nó, esquerda)
+    while (atual != NULL || pilha.tamanho > 0) {
+        // Descer pela direita, ignorando subárvores fora do intervalo
+        while (atual != NULL && dentroDaProfundidade(exp, profundidade)) {
+            // O identificador é reservado aqui, pois o filho direito é
+            // escrito antes do próprio nó
+            int id = dentroDoIntervalo(exp, atual->valor) ? exp->proximoId++ : idPai;
+            empilhar(&pilha, atual, profundidade, id, idPai);
+            if (atual->valor >= opcoes.chaveMax) {
                 break;
-                
-            case 2: // AVL
-                do {
-                    printf("\n--- Operacoes com AVL ---\n");
-                    printf("1. Inserir valor\n");
-                    printf("2. Remover valor\n");
-                    printf("3. Exibir arvore\n");
-                    printf("0. Voltar\n");
+            }
+            atual = atual->direita;
+            profundidade++;
+            idPai = id;
+        }
+        
+        if (pilha.tamanho == 0) {
+            break;
+        }
+        
+        ItemPilha item = pilha.itens[--pilha.tamanho];
+        NoBST* no = (NoBST*)item.no;
+        
+        if (dentroDoIntervalo(exp, no->valor)) {
+            iniciarNoExportado(exp, item.id, item.profundidade, item.idPai);
+            if (opcoes.formato == FORMATO_JSON) {
+                escreverTexto(exp, "\"valor\": ");
+                escreverInteiro(exp, no->valor);
+                escreverTexto(exp, no->removido ? ", \"removido\": true" : ", \"removido\": false");
+            } else {
+                escreverInteiro(exp, no->valor);
+                if (no->removido) {
+                    escreverTexto(exp, " (removido)");
+                }
+            }
+            finalizarNoExportado(exp, item.id, item.idPai);
+        }
+        
+        // Os filhos de um nó fora do intervalo herdam o ancestral exportado
+        atual = (no->valor > opcoes.chaveMin) ? no->esquerda : NULL;
+        profundidade = item.profundidade + 1;
+        idPai = item.id;
+    }
+    
+    finalizarExportacao(exp);
+    free(pilha.itens);
+    free(exp);
+}
+
+// Exportar árvore AVL sem recursão, na mesma ordem visual de exibirAVL
+void exportarAVL(FILE* arquivo, NoAVL* raiz, OpcoesExportacao opcoes) {
+    Exportador* exp = criarExportador(arquivo, opcoes);
+    PilhaPercurso pilha = {NULL, 0, 0};
+    NoAVL* atual = raiz;
+    int profundidade = 0;
+    int idPai = -1;
+    
+    iniciarExportacao(exp, "AVL");
+    
+    // Percurso em ordem invertida (direita, nó, esquerda)
+    while (atual != NULL || pilha.tamanho > 0) {
+        // Descer pela direita, ignorando subárvores fora do intervalo
+        while (atual != NULL && dentroDaProfundidade(exp, profundidade)) {
+            // O identificador é reservado aqui, pois o filho direito é
+            // escrito antes do próprio nó
+            int id = dentroDoIntervalo(exp, atual->valor) ? exp->proximoId++ : idPai;
+            empilhar(&pilha, atual, profundidade, id, idPai);
+            if (atual->valor >= opcoes.chaveMax) {
+                break;
+            }
+            atual = atual->direita;
+            profundidade++;
+            idPai = id;
+        }
+        
+        if (pilha.tamanho == 0) {
+            break;
+        }
+        
+        ItemPilha item = pilha.itens[--pilha.tamanho];
+        NoAVL* no = (NoAVL*)item.no;
+        
+        if (dentroDoIntervalo(exp, no->valor)) {
+            iniciarNoExportado(exp, item.id, item.profundidade, item.idPai);
+            if (opcoes.formato == FORMATO_JSON) {
+                escreverTexto(exp, "\"valor\": ");
+                escreverInteiro(exp, no->valor);
+                escreverTexto(exp, ", \"altura\": ");
+                escreverInteiro(exp, no->altura);
+                escreverTexto(exp, no->removido ? ", \"removido\": true" : ", \"removido\": false");
+            } else {
+                escreverInteiro(exp, no->valor);
+                escreverTexto(exp, " (h=");
+                escreverInteiro(exp, no->altura);
+                escreverTexto(exp, no->removido ? ") (removido)" : ")");
+            }
+            finalizarNoExportado(exp, item.id, item.idPai);
+        }
+        
+        // Os filhos de um nó fora do intervalo herdam o ancestral exportado
+        atual = (no->valor > opcoes.chaveMin) ? no->esquerda : NULL;
+        profundidade = item.profundidade + 1;
+        idPai = item.id;
+    }
+    
+    finalizarExportacao(exp);
+    free(pilha.itens);
+    free(exp);
+}
+
+// Exportar árvore 2-3-4 sem recursão, na mesma ordem visual de exibir234
+void exportar234(FILE* arquivo, No234* raiz, OpcoesExportacao opcoes) {
+    Exportador* exp = criarExportador(arquivo, opcoes);
+    PilhaPercurso pilha = {NULL, 0, 0};
+    
+    iniciarExportacao(exp, "Arvore234");
+    
+    if (raiz != NULL) {
+        empilhar(&pilha, raiz, 0, -1, -1);
+    }
+    
+    // Percurso em pré-ordem
+    while (pilha.tamanho > 0) {
+        ItemPilha item = pilha.itens[--pilha.tamanho];
+        No234* no = (No234*)item.no;
+        int id = item.idPai;
+        int primeira = 1;
+        int i;
+        
+        for (i = 0; i < no->numChaves; i++) {
+            if (!dentroDoIntervalo(exp, no->chaves[i])) {
+                continue;
+            }
+            
+            if (primeira) {
+                id = exp->proximoId++;
+                iniciarNoExportado(exp, id, item.profundidade, item.idPai);
+                escreverTexto(exp, opcoes.formato == FORMATO_JSON ? "\"chaves\": [" : "[");
+                primeira = 0;
+            } else {
+                escreverTexto(exp, ", ");
+            }
+            escreverInteiro(exp, no->chaves[i]);
+        }
+        
+        if (!primeira) {
+            escreverTexto(exp, "]");
+            finalizarNoExportado(exp, id, item.idPai);
+        }
+        
+        if (ehFolha(no) || !dentroDaProfundidade(exp, item.profundidade + 1)) {
+            continue;
+        }
+        
+        // Empilhar em ordem inversa para visitar o primeiro filho antes;
+        // o filho i contém apenas chaves entre chaves[i-1] e chaves[i]
+        for (i = no->numChaves; i >= 0; i--) {
+            if (no->filhos[i] == NULL) {
+                continue;
+            }
+            if (i > 0 && no->chaves[i - 1] >= opcoes.chaveMax) {
+                continue;
+            }
+            if (i < no->numChaves && no->chaves[i] <= opcoes.chaveMin) {
+                continue;
+            }
+            empilhar(&pilha, no->filhos[i], item.profundidade + 1, -1, id);
+        }
+    }
+    
+    finalizarExportacao(exp);
+    free(pilha.itens);
+    free(exp);
+}
+
+// Descartar o restante da linha de entrada após uma leitura inválida
+void descartarLinha() {
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF) {
+    }
+}
+
+// Ler opções de exportação do usuário; retorna o arquivo de saída, ou NULL
+// se alguma opção for inválida
+FILE* lerOpcoesExportacao(OpcoesExportacao* opcoes) {
+    char nomeArquivo[256];
+    FILE* arquivo;
+    
+    *opcoes = opcoesExportacaoPadrao();
+    printf("Formato (0 = texto, 1 = DOT, 2 = JSON): ");
+    if (scanf("%d", &opcoes->formato) != 1 ||
+        opcoes->formato < FORMATO_TEXTO || opcoes->formato > FORMATO_JSON) {
+        printf("Formato invalido!\n");
+        descartarLinha();
+        return NULL;
+    }
+    printf("Profundidade maxima (-1 para sem limite): ");
+    if (scanf("%d", &opcoes->profundidadeMax) != 1) {
+        printf("Profundidade invalida!\n");
+        descartarLinha();
+        return NULL;
+    }
+    printf("Intervalo de chaves (min max): ");
+    if (scanf("%d %d", &opcoes->chaveMin, &opcoes->chaveMax) != 2) {
+        printf("Intervalo invalido!\n");
+        descartarLinha();
+        return NULL;
+    }
+    printf("Arquivo de saida (- para a tela): ");
+    if (scanf("%255s", nomeArquivo) != 1) {
+        return NULL;
+    }
+    
+    if (strcmp(nomeArquivo, "-") == 0) {
+        return stdout;
+    }
+    
+    arquivo = fopen(nomeArquivo, "w");
+    if (arquivo == NULL) {
+        printf("Nao foi possivel abrir o arquivo %s\n", nomeArquivo);
+    }
+    return arquivo;
+}
+
+// ======== SERVIDOR (SOCKET UNIX) ========
+
+#ifdef __linux__
+
+// Protocolo binário (ordem de bytes nativa, pois cliente e servidor estão
+// na mesma máquina). Cada requisição ocupa 12 bytes:
+//   operacao (1 byte), tipoArvore (1 byte), instancia (2 bytes),
+//   chave (4 bytes), chave2 (4 bytes, limite superior do intervalo)
+// Cada resposta começa com status (4 bytes) e quantidade (4 bytes),
+// seguidos de 'quantidade' inteiros de 4 bytes.
+// O cliente pode enviar várias requisições sem esperar as respostas;
+// todas as requisições completas recebidas são processadas em lote e as
+// respostas são enviadas juntas, na mesma ordem.
+// Estatísticas devolvem: chaves presentes, nós marcados como removidos,
+// altura e taxa de acertos do cache de chaves quentes (em centésimos de %).
+// Uma consulta de intervalo devolve no máximo MAX_RESULTADOS_INTERVALO
+// chaves; se houver mais, o status é STATUS_PARCIAL e o cliente continua
+// a partir da última chave recebida + 1.
+
+#define OP_INSERIR 1
+#define OP_BUSCAR 2
+#define OP_REMOVER 3
+#define OP_INTERVALO 4
+#define OP_ESTATISTICAS 5
+
+#define ARVORE_AVL 1
+#define ARVORE_234 2
+
+#define STATUS_OK 0
+#define STATUS_NAO_ENCONTRADO 1
+#define STATUS_INVALIDO 2
+#define STATUS_NAO_SUPORTADO 3
+#define STATUS_PARCIAL 4
+
+#define TAMANHO_REQUISICAO 12
+#define TAMANHO_CABECALHO_RESPOSTA 8
+
+// Instâncias de cada tipo de árvore servidas simultaneamente
+#define MAX_INSTANCIAS 16
+// Máximo de chaves devolvidas por uma consulta de intervalo
+#define MAX_RESULTADOS_INTERVALO 4096
+// A coleta busca uma chave a mais para saber se o resultado foi cortado
+#define LIMITE_COLETA (MAX_RESULTADOS_INTERVALO + 1)
+#define MAX_EVENTOS 64
+// Tempo máximo, em µs, gasto com compactação a cada volta do laço de eventos
+#define ORCAMENTO_COMPACTACAO_US 500
+// Pausa, em ms, antes de voltar a aceitar conexões após um erro em accept
+#define PAUSA_ACEITACAO_MS 100
+#define TAMANHO_ENTRADA (TAMANHO_REQUISICAO * 1024)
+// Acima desse volume de respostas pendentes a conexão deixa de ser lida
+#define LIMITE_SAIDA_PENDENTE (1 << 20)
+
+// Requisição decodificada
+typedef struct Requisicao {
+    int operacao;
+    int tipoArvore;
+    int instancia;
+    int chave;
+    int chave2;
+} Requisicao;
+
+// Instância de árvore AVL servida
+typedef struct InstanciaAVL {
+    NoAVL* raiz;
+    ControleRemocao controle;
+    int compactando;      // 1 do limiar até esvaziar a lista de pendentes
+    CacheQuente cache;
+} InstanciaAVL;
+
+// Instância de árvore 2-3-4 servida
+typedef struct Instancia234 {
+    No234* raiz;
+    int numChaves;
+    CacheQuente cache;
+} Instancia234;
+
+// Estado do servidor
+typedef struct Servidor {
+    int fdEscuta;
+    int fdEpoll;
+    int escutaPausada;    // 1 se novas conexões estão suspensas após erro em accept
+    long long retomarEscutaEm;  // Instante (µs) em que a escuta suspensa é retomada
+    InstanciaAVL avl[MAX_INSTANCIAS];
+    Instancia234 arvores234[MAX_INSTANCIAS];
+    int resultados[LIMITE_COLETA];
+} Servidor;
+
+// Conexão de um cliente
+typedef struct Conexao {
+    int fd;
+    unsigned char entrada[TAMANHO_ENTRADA];
+    size_t usadoEntrada;
+    unsigned char* saida;
+    size_t usadoSaida;
+    size_t enviadoSaida;
+    size_t capacidadeSaida;
+    int encerrando;       // 1 se o cliente fechou o envio; fecha após enviar as respostas
+} Conexao;
+
+volatile sig_atomic_t servidorAtivo = 1;
+
+// Tempo atual em microssegundos
+long long agoraMicrossegundos() {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (long long)t.tv_sec * 1000000LL + t.tv_nsec / 1000;
+}
+
+// Encerrar o servidor ao receber SIGINT ou SIGTERM
+void tratarSinalServidor(int sinal) {
+    (void)sinal;
+    servidorAtivo = 0;
+}
+
+// Coletar chaves da árvore AVL no intervalo [minimo, maximo], em ordem
+void coletarIntervaloAVL(NoAVL* raiz, int minimo, int maximo, int* resultados, int* quantidade) {
+    if (raiz == NULL || *quantidade == LIMITE_COLETA) {
+        return;
+    }
+    if (raiz->valor > minimo) {
+        coletarIntervaloAVL(raiz->esquerda, minimo, maximo, resultados, quantidade);
+    }
+    if (raiz->valor >= minimo && raiz->valor <= maximo && !raiz->removido &&
+        *quantidade < LIMITE_COLETA) {
+        resultados[(*quantidade)++] = raiz->valor;
+    }
+    if (raiz->valor < maximo) {
+        coletarIntervaloAVL(raiz->direita, minimo, maximo, resultados, quantidade);
+    }
+}
+
+// Coletar chaves da árvore 2-3-4 no intervalo [minimo, maximo], em ordem
+void coletarIntervalo234(No234* raiz, int minimo, int maximo, int* resultados, int* quantidade) {
+    if (raiz == NULL) {
+        return;
+    }
+    for (int i = 0; i <= raiz->numChaves && *quantidade < LIMITE_COLETA; i++) {
+        if ((i == 0 || raiz->chaves[i - 1] < maximo) &&
+            (i == raiz->numChaves || raiz->chaves[i] > minimo)) {
+            coletarIntervalo234(raiz->filhos[i], minimo, maximo, resultados, quantidade);
+        }
+        if (i < raiz->numChaves && raiz->chaves[i] >= minimo && raiz->chaves[i] <= maximo &&
+            *quantidade < LIMITE_COLETA) {
+            resultados[(*quantidade)++] = raiz->chaves[i];
+        }
+    }
+}
+
+// Calcular altura da árvore 2-3-4 (todas as folhas estão no mesmo nível)
+int altura234(No234* raiz) {
+    int h = 0;
+    while (raiz != NULL) {
+        h++;
+        raiz = raiz->filhos[0];
+    }
+    return h;
+}
+
+// Garantir espaço no buffer de saída da conexão
+void reservarSaida(Conexao* conexao, size_t tamanho) {
+    if (conexao->usadoSaida + tamanho <= conexao->capacidadeSaida) {
+        return;
+    }
+    size_t novaCapacidade = conexao->capacidadeSaida ? conexao->capacidadeSaida : 4096;
+    while (novaCapacidade < conexao->usadoSaida + tamanho) {
+        novaCapacidade *= 2;
+    }
+    unsigned char* nova = (unsigned char*)realloc(conexao->saida, novaCapacidade);
+    if (nova == NULL) {
+        fprintf(stderr, "Erro na alocação de memória\n");
+        exit(EXIT_FAILURE);
+    }
+    conexao->saida = nova;
+    conexao->capacidadeSaida = novaCapacidade;
+}
+
+// Acrescentar resposta ao buffer de saída da conexão
+void escreverResposta(Conexao* conexao, int status, const int* valores, int quantidade) {
+    int32_t cabecalho[2];
+    cabecalho[0] = status;
+    cabecalho[1] = quantidade;
+    
+    reservarSaida(conexao, TAMANHO_CABECALHO_RESPOSTA + (size_t)quantidade * sizeof(int32_t));
+    memcpy(conexao->saida + conexao->usadoSaida, cabecalho, TAMANHO_CABECALHO_RESPOSTA);
+    conexao->usadoSaida += TAMANHO_CABECALHO_RESPOSTA;
+    for (int i = 0; i < quantidade; i++) {
+        int32_t valor = valores[i];
+        memcpy(conexao->saida + conexao->usadoSaida, &valor, sizeof(int32_t));
+        conexao->usadoSaida += sizeof(int32_t);
+    }
+}
+
+// Responder consulta de intervalo; se houver mais chaves que o máximo,
+// devolve as primeiras com STATUS_PARCIAL
+void responderIntervalo(Conexao* conexao, const int* resultados, int quantidade) {
+    if (quantidade > MAX_RESULTADOS_INTERVALO) {
+        escreverResposta(conexao, STATUS_PARCIAL, resultados, MAX_RESULTADOS_INTERVALO);
+    } else {
+        escreverResposta(conexao, STATUS_OK, resultados, quantidade);
+    }
+}
+
+// Decodificar requisição a partir dos bytes recebidos
+Requisicao decodificarRequisicao(const unsigned char* dados) {
+    Requisicao req;
+    uint16_t instancia;
+    int32_t chave, chave2;
+    
+    memcpy(&instancia, dados + 2, sizeof(instancia));
+    memcpy(&chave, dados + 4, sizeof(chave));
+    memcpy(&chave2, dados + 8, sizeof(chave2));
+    req.operacao = dados[0];
+    req.tipoArvore = dados[1];
+    req.instancia = instancia;
+    req.chave = chave;
+    req.chave2 = chave2;
+    return req;
+}
+
+// Executar requisição sobre uma instância AVL
+void executarAVL(Servidor* servidor, InstanciaAVL* inst, Requisicao* req, Conexao* conexao) {
+    int quantidade = 0;
+    
+    switch (req->operacao) {
+        case OP_INSERIR:
+            inst->raiz = inserirAVLControlado(inst->raiz, req->chave, &inst->controle);
+            escreverResposta(conexao, STATUS_OK, NULL, 0);
+            break;
+        case OP_BUSCAR:
+            escreverResposta(conexao, buscarAVLComCache(&inst->cache, inst->raiz, req->chave)
+                             ? STATUS_OK : STATUS_NAO_ENCONTRADO, NULL, 0);
+            break;
+        case OP_REMOVER:
+            // Remoção preguiçosa: rajadas de remoção não reestruturam a
+            // árvore; a remoção física acontece quando o servidor está ocioso
+            invalidarCache(&inst->cache, req->chave);
+            escreverResposta(conexao, removerPreguicosoAVL(inst->raiz, req->chave, &inst->controle)
+                             ? STATUS_OK : STATUS_NAO_ENCONTRADO, NULL, 0);
+            break;
+        case OP_INTERVALO:
+            coletarIntervaloAVL(inst->raiz, req->chave, req->chave2, servidor->resultados, &quantidade);
+            responderIntervalo(conexao, servidor->resultados, quantidade);
+            break;
+        case OP_ESTATISTICAS:
+            servidor->resultados[0] = inst->controle.numNos - inst->controle.numRemovidos;
+            servidor->resultados[1] = inst->controle.numRemovidos;
+            servidor->resultados[2] = altura(inst->raiz);
+            servidor->resultados[3] = (int)(taxaAcertosCache(&inst->cache) * 100);
+            escreverResposta(conexao, STATUS_OK, servidor->resultados, 4);
+            break;
+        default:
+            escreverResposta(conexao, STATUS_INVALIDO, NULL, 0);
+    }
+}
+
+// Executar requisição sobre uma instância 2-3-4
+void executar234(Servidor* servidor, Instancia234* inst, Requisicao* req, Conexao* conexao) {
+    No234* noEncontrado = NULL;
+    int posicao = -1;
+    int quantidade = 0;
+    
+    switch (req->operacao) {
+        case OP_INSERIR:
+            // inserir234 não rejeita duplicatas
+            if (!buscar234(inst->raiz, req->chave, &noEncontrado, &posicao)) {
+                inst->raiz = inserir234(inst->raiz, req->chave);
+                inst->numChaves++;
+            }
+            escreverResposta(conexao, STATUS_OK, NULL, 0);
+            break;
+        case OP_BUSCAR:
+            escreverResposta(conexao, buscar234ComCache(&inst->cache, inst->raiz, req->chave)
+                             ? STATUS_OK : STATUS_NAO_ENCONTRADO, NULL, 0);
+            break;
+        case OP_INTERVALO:
+            coletarIntervalo234(inst->raiz, req->chave, req->chave2, servidor->resultados, &quantidade);
+            responderIntervalo(conexao, servidor->resultados, quantidade);
+            break;
+        case OP_ESTATISTICAS:
+            servidor->resultados[0] = inst->numChaves;
+            servidor->resultados[1] = 0;
+            servidor->resultados[2] = altura234(inst->raiz);
+            servidor->resultados[3] = (int)(taxaAcertosCache(&inst->cache) * 100);
+            escreverResposta(conexao, STATUS_OK, servidor->resultados, 4);
+            break;
+        case OP_REMOVER:
+            // A árvore 2-3-4 não implementa remoção
+            escreverResposta(conexao, STATUS_NAO_SUPORTADO, NULL, 0);
+            break;
+        default:
+            escreverResposta(conexao, STATUS_INVALIDO, NULL, 0);
+    }
+}
+
+// Processar todas as requisições completas do buffer de entrada
+void processarEntrada(Servidor* servidor, Conexao* conexao) {
+    size_t pos = 0;
+    
+    while (conexao->usadoEntrada - pos >= TAMANHO_REQUISICAO) {
+        Requisicao req = decodificarRequisicao(conexao->entrada + pos);
+        pos += TAMANHO_REQUISICAO;
+        
+        if (req.instancia >= MAX_INSTANCIAS) {
+            escreverResposta(conexao, STATUS_INVALIDO, NULL, 0);
+        } else if (req.tipoArvore == ARVORE_AVL) {
+            executarAVL(servidor, &servidor->avl[req.instancia], &req, conexao);
+        } else if (req.tipoArvore == ARVORE_234) {
+            executar234(servidor, &servidor->arvores234[req.instancia], &req, conexao);
+        } else {
+            escreverResposta(conexao, STATUS_INVALIDO, NULL, 0);
+        }
+    }
+    
+    // Manter a requisição incompleta no início do buffer
+    memmove(conexao->entrada, conexao->entrada + pos, conexao->usadoEntrada - pos);
+    conexao->usadoEntrada -= pos;
+}
+
+// Compactar as instâncias AVL em andamento, dentro do orçamento de tempo
+void compactarInstancias(Servidor* servidor) {
+    long long limite = agoraMicrossegundos() + ORCAMENTO_COMPACTACAO_US;
+    int restante = 1;
+    
+    // Fatias pequenas alternadas entre as instâncias até esgotar o tempo
+    while (restante && agoraMicrossegundos() < limite) {
+        restante = 0;
+        for (int i = 0; i < MAX_INSTANCIAS; i++) {
+            InstanciaAVL* inst = &servidor->avl[i];
+            if (!inst->compactando) {
+                continue;
+            }
+            inst->raiz = compactarAVL(inst->raiz, &inst->controle, FATIA_COMPACTACAO);
+            inst->compactando = inst->controle.numPendentes > 0;
+            restante |= inst->compactando;
+        }
+    }
+}
+
+// Verificar se alguma instância AVL tem compactação em andamento; uma
+// instância que passa do limiar é compactada até esvaziar seus pendentes
+int haCompactacaoPendente(Servidor* servidor) {
+    int pendente = 0;
+    for (int i = 0; i < MAX_INSTANCIAS; i++) {
+        InstanciaAVL* inst = &servidor->avl[i];
+        if (deveCompactar(&inst->controle)) {
+            inst->compactando = 1;
+        }
+        pendente |= inst->compactando;
+    }
+    return pendente;
+}
+
+// Enviar respostas pendentes; retorna 0 se a conexão deve ser fechada
+int enviarSaida(Conexao* conexao) {
+    while (conexao->enviadoSaida < conexao->usadoSaida) {
+        ssize_t n = write(conexao->fd, conexao->saida + conexao->enviadoSaida,
+                          conexao->usadoSaida - conexao->enviadoSaida);
+        if (n < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        conexao->enviadoSaida += (size_t)n;
+    }
+    conexao->usadoSaida = 0;
+    conexao->enviadoSaida = 0;
+    return 1;
+}
+
+// Atualizar os eventos monitorados conforme o estado da conexão
+void atualizarEventos(Servidor* servidor, Conexao* conexao) {
+    struct epoll_event ev;
+    size_t pendente = conexao->usadoSaida - conexao->enviadoSaida;
+    
+    ev.events = 0;
+    if (!conexao->encerrando && pendente < LIMITE_SAIDA_PENDENTE) {
+        ev.events |= EPOLLIN;
+    }
+    if (pendente > 0) {
+        ev.events |= EPOLLOUT;
+    }
+    ev.data.ptr = conexao;
+    epoll_ctl(servidor->fdEpoll, EPOLL_CTL_MOD, conexao->fd, &ev);
+}
+
+// Ativar ou suspender o monitoramento do socket de escuta
+void monitorarEscuta(Servidor* servidor, int ativo) {
+    struct epoll_event ev;
+    ev.events = ativo ? EPOLLIN : 0;
+    ev.data.ptr = NULL;
+    epoll_ctl(servidor->fdEpoll, EPOLL_CTL_MOD, servidor->fdEscuta, &ev);
+    servidor->escutaPausada = !ativo;
+    if (!ativo) {
+        servidor->retomarEscutaEm = agoraMicrossegundos() + PAUSA_ACEITACAO_MS * 1000LL;
+    }
+}
+
+// Fechar conexão e liberar seus recursos
+void fecharConexao(Servidor* servidor, Conexao* conexao) {
+    epoll_ctl(servidor->fdEpoll, EPOLL_CTL_DEL, conexao->fd, NULL);
+    close(conexao->fd);
+    free(conexao->saida);
+    free(conexao);
+    
+    // Um descritor foi liberado: voltar a aceitar conexões
+    if (servidor->escutaPausada) {
+        monitorarEscuta(servidor, 1);
+    }
+}
+
+// Aceitar todas as conexões pendentes
+void aceitarConexoes(Servidor* servidor) {
+    for (;;) {
+        int fd = accept(servidor->fdEscuta, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) {
+                return;
+            }
+            if (errno == EINTR || errno == ECONNABORTED) {
+                continue;
+            }
+            // Erros persistentes (como EMFILE) manteriam o socket de escuta
+            // sempre pronto; suspendê-lo evita um laço ocupado
+            perror("Erro ao aceitar conexao");
+            monitorarEscuta(servidor, 0);
+            return;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        
+        Conexao* conexao = (Conexao*)malloc(sizeof(Conexao));
+        if (conexao == NULL) {
+            fprintf(stderr, "Erro na alocação de memória\n");
+            exit(EXIT_FAILURE);
+        }
+        conexao->fd = fd;
+        conexao->usadoEntrada = 0;
+        conexao->saida = NULL;
+        conexao->usadoSaida = 0;
+        conexao->enviadoSaida = 0;
+        conexao->capacidadeSaida = 0;
+        conexao->encerrando = 0;
+        
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = conexao;
+        epoll_ctl(servidor->fdEpoll, EPOLL_CTL_ADD, fd, &ev);
+    }
+}
+
+// Ler dados do cliente; retorna 0 se a conexão deve ser fechada
+int lerConexao(Servidor* servidor, Conexao* conexao) {
+    for (;;) {
+        ssize_t n = read(conexao->fd, conexao->entrada + conexao->usadoEntrada,
+                         TAMANHO_ENTRADA - conexao->usadoEntrada);
+        if (n == 0) {
+            // Fim do envio do cliente: as respostas já enfileiradas ainda
+            // precisam ser entregues antes de fechar
+            conexao->encerrando = 1;
+            return 1;
+        }
+        if (n < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        conexao->usadoEntrada += (size_t)n;
+        processarEntrada(servidor, conexao);
+        
+        if (conexao->usadoSaida - conexao->enviadoSaida >= LIMITE_SAIDA_PENDENTE) {
+            return 1;
+        }
+    }
+}
+
+// Executar o servidor no socket informado até receber SIGINT ou SIGTERM
+int executarServidor(const char* caminho) {
+    struct sockaddr_un endereco;
+    struct epoll_event eventos[MAX_EVENTOS];
+    struct epoll_event ev;
+    
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        fprintf(stderr, "Caminho do socket muito longo: %s\n", caminho);
+        return EXIT_FAILURE;
+    }
+    
+    Servidor* servidor = (Servidor*)malloc(sizeof(Servidor));
+    if (servidor == NULL) {
+        fprintf(stderr, "Erro na alocação de memória\n");
+        exit(EXIT_FAILURE);
+    }
+    for (int i = 0; i < MAX_INSTANCIAS; i++) {
+        servidor->avl[i].raiz = NULL;
+        iniciarControleRemocao(&servidor->avl[i].controle);
+        servidor->avl[i].compactando = 0;
+        iniciarCache(&servidor->avl[i].cache);
+        servidor->arvores234[i].raiz = NULL;
+        servidor->arvores234[i].numChaves = 0;
+        iniciarCache(&servidor->arvores234[i].cache);
+    }
+    
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strcpy(endereco.sun_path, caminho);
+    unlink(caminho);
+    
+    servidor->fdEscuta = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (servidor->fdEscuta < 0 ||
+        bind(servidor->fdEscuta, (struct sockaddr*)&endereco, sizeof(endereco)) < 0 ||
+        listen(servidor->fdEscuta, SOMAXCONN) < 0) {
+        perror("Erro ao abrir o socket");
+        free(servidor);
+        return EXIT_FAILURE;
+    }
+    fcntl(servidor->fdEscuta, F_SETFL, fcntl(servidor->fdEscuta, F_GETFL) | O_NONBLOCK);
+    
+    servidor->fdEpoll = epoll_create1(0);
+    servidor->escutaPausada = 0;
+    servidor->retomarEscutaEm = 0;
+    ev.events = EPOLLIN;
+    ev.data.ptr = NULL;  // NULL identifica o socket de escuta
+    epoll_ctl(servidor->fdEpoll, EPOLL_CTL_ADD, servidor->fdEscuta, &ev);
+    
+    signal(SIGINT, tratarSinalServidor);
+    signal(SIGTERM, tratarSinalServidor);
+    signal(SIGPIPE, SIG_IGN);
+    printf("Servidor aguardando conexoes em %s\n", caminho);
+    fflush(stdout);
+    
+    while (servidorAtivo) {
+        // Com compactação em andamento o laço não bloqueia: os eventos
+        // prontos são atendidos e depois uma fatia limitada por tempo é
+        // executada, mesmo sob tráfego constante
+        int compactar = haCompactacaoPendente(servidor);
+        int espera = compactar ? 0 : -1;
+        if (servidor->escutaPausada) {
+            // Esperar no máximo até o prazo de retomada da escuta
+            long long restante = servidor->retomarEscutaEm - agoraMicrossegundos();
+            int esperaRetomada = restante > 0 ? (int)((restante + 999) / 1000) : 0;
+            if (espera < 0 || espera > esperaRetomada) {
+                espera = esperaRetomada;
+            }
+        }
+        int n = epoll_wait(servidor->fdEpoll, eventos, MAX_EVENTOS, espera);
+        
+        // O prazo é verificado a cada volta, pois sob tráfego constante
+        // epoll_wait pode nunca expirar
+        if (servidor->escutaPausada && agoraMicrossegundos() >= servidor->retomarEscutaEm) {
+            monitorarEscuta(servidor, 1);
+        }
+        
+        for (int i = 0; i < n; i++) {
+            Conexao* conexao = (Conexao*)eventos[i].data.ptr;
+            
+            if (conexao == NULL) {
+                aceitarConexoes(servidor);
+                continue;
+            }
+            
+            int ativa = 1;
+            if (!conexao->encerrando && (eventos[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))) {
+                ativa = lerConexao(servidor, conexao);
+            }
+            
+            // Todas as respostas do lote são enviadas de uma vez
+            if (ativa) {
+                ativa = enviarSaida(conexao);
+            }
+            
+            // Conexão encerrada pelo cliente e sem respostas pendentes
+            if (ativa && conexao->encerrando && conexao->usadoSaida == conexao->enviadoSaida) {
+                ativa = 0;
+            }
+            
+            if (ativa) {
+                atualizarEventos(servidor, conexao);
+            } else {
+                fecharConexao(servidor, conexao);
+            }
+        }
+        
+        if (compactar) {
+            compactarInstancias(servidor);
+        }
+    }
+    
+    // Conexões ainda abertas são encerradas junto com o processo
+    close(servidor->fdEpoll);
+    close(servidor->fdEscuta);
+    unlink(caminho);
+    for (int i = 0; i < MAX_INSTANCIAS; i++) {
+        liberarAVL(servidor->avl[i].raiz);
+        liberarControleRemocao(&servidor->avl[i].controle);
+        liberar234(servidor->arvores234[i].raiz);
+    }
+    free(servidor);
+    printf("Servidor encerrado.\n");
+    return EXIT_SUCCESS;
+}
+
+// ======== GERADOR DE CARGA ========
+
+// Tamanho do buffer de recepção do gerador de carga; comporta a maior
+// resposta possível (intervalo com MAX_RESULTADOS_INTERVALO chaves)
+#define TAMANHO_RECEPCAO (1 << 16)
+
+// Enviar um lote e receber suas respostas ao mesmo tempo, com o socket não
+// bloqueante. Enviar tudo antes de ler travaria com lotes grandes: o
+// servidor para de ler quando acumula respostas demais e ambos ficariam
+// bloqueados com os buffers cheios. Retorna 0 em caso de erro.
+int trocarLote(int fd, const unsigned char* lote, int numRequisicoes, unsigned char* recepcao) {
+    size_t enviados = 0, total = (size_t)numRequisicoes * TAMANHO_REQUISICAO;
+    size_t usado = 0;
+    int recebidas = 0;
+    
+    while (recebidas < numRequisicoes) {
+        struct pollfd p;
+        p.fd = fd;
+        p.events = POLLIN | (enviados < total ? POLLOUT : 0);
+        p.revents = 0;
+        if (poll(&p, 1, -1) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("Erro em poll");
+            return 0;
+        }
+        
+        if (p.revents & POLLOUT) {
+            ssize_t k = write(fd, lote + enviados, total - enviados);
+            if (k < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                perror("Erro ao enviar requisicoes");
+                return 0;
+            }
+            if (k > 0) {
+                enviados += (size_t)k;
+            }
+        }
+        
+        if (p.revents & (POLLIN | POLLHUP | POLLERR)) {
+            ssize_t k = read(fd, recepcao + usado, TAMANHO_RECEPCAO - usado);
+            if (k == 0) {
+                fprintf(stderr, "Conexao encerrada pelo servidor\n");
+                return 0;
+            }
+            if (k < 0) {
+                if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                    continue;
+                }
+                perror("Erro ao receber respostas");
+                return 0;
+            }
+            usado += (size_t)k;
+            
+            // Consumir as respostas completas recebidas
+            size_t pos = 0;
+            while (usado - pos >= TAMANHO_CABECALHO_RESPOSTA) {
+                int32_t cabecalho[2];
+                memcpy(cabecalho, recepcao + pos, sizeof(cabecalho));
+                size_t tamanho = TAMANHO_CABECALHO_RESPOSTA + (size_t)cabecalho[1] * sizeof(int32_t);
+                if (usado - pos < tamanho) {
+                    break;
+                }
+                pos += tamanho;
+                recebidas++;
+            }
+            memmove(recepcao, recepcao + pos, usado - pos);
+            usado -= pos;
+        }
+    }
+    return 1;
+}
+
+// Codificar requisição no formato do protocolo
+void codificarRequisicao(unsigned char* destino, int operacao, int tipoArvore, int instancia, int chave, int chave2) {
+    uint16_t inst = (uint16_t)instancia;
+    int32_t c1 = chave, c2 = chave2;
+    
+    destino[0] = (unsigned char)operacao;
+    destino[1] = (unsigned char)tipoArvore;
+    memcpy(destino + 2, &inst, sizeof(inst));
+    memcpy(destino + 4, &c1, sizeof(c1));
+    memcpy(destino + 8, &c2, sizeof(c2));
+}
+
+// Comparar inteiros longos (para qsort)
+int compararLongos(const void* a, const void* b) {
+    long long x = *(const long long*)a;
+    long long y = *(const long long*)b;
+    return (x > y) - (x < y);
+}
+
+// Medir vazão e latência do servidor com lotes de requisições em pipeline
+int executarCarga(const char* caminho, int numRequisicoes, int tamanhoLote, int tipoArvore) {
+    struct sockaddr_un endereco;
+    int numLotes = (numRequisicoes + tamanhoLote - 1) / tamanhoLote;
+    unsigned char* lote = (unsigned char*)malloc((size_t)tamanhoLote * TAMANHO_REQUISICAO);
+    long long* latencias = (long long*)malloc((size_t)numLotes * sizeof(long long));
+    unsigned char* recepcao = (unsigned char*)malloc(TAMANHO_RECEPCAO);
+    int chaves = numRequisicoes / 2 + 1;
+    int resultado = EXIT_SUCCESS;
+    int fd;
+    
+    if (lote == NULL || latencias == NULL || recepcao == NULL) {
+        fprintf(stderr, "Erro na alocação de memória\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    strncpy(endereco.sun_path, caminho, sizeof(endereco.sun_path) - 1);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&endereco, sizeof(endereco)) < 0) {
+        perror("Erro ao conectar ao servidor");
+        free(lote);
+        free(latencias);
+        free(recepcao);
+        return EXIT_FAILURE;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+    
+    srand(42);
+    long long inicio = agoraMicrossegundos();
+    
+    for (int l = 0; l < numLotes; l++) {
+        int n = tamanhoLote;
+        if (l == numLotes - 1) {
+            n = numRequisicoes - l * tamanhoLote;
+        }
+        
+        // Carga mista: 40% inserções, 50% buscas, 10% remoções
+        for (int i = 0; i < n; i++) {
+            int sorteio = rand() % 10;
+            int operacao = sorteio < 4 ? OP_INSERIR : (sorteio < 9 ? OP_BUSCAR : OP_REMOVER);
+            if (operacao == OP_REMOVER && tipoArvore == ARVORE_234) {
+                operacao = OP_BUSCAR;
+            }
+            codificarRequisicao(lote + (size_t)i * TAMANHO_REQUISICAO, operacao, tipoArvore, 0, rand() % chaves, 0);
+        }
+        
+        long long inicioLote = agoraMicrossegundos();
+        if (!trocarLote(fd, lote, n, recepcao)) {
+            resultado = EXIT_FAILURE;
+            break;
+        }
+        latencias[l] = agoraMicrossegundos() - inicioLote;
+    }
+    
+    if (resultado != EXIT_SUCCESS) {
+        close(fd);
+        free(lote);
+        free(latencias);
+        free(recepcao);
+        return resultado;
+    }
+    
+    long long duracao = agoraMicrossegundos() - inicio;
+    qsort(latencias, (size_t)numLotes, sizeof(long long), compararLongos);
+    
+    printf("Requisicoes: %d em lotes de %d\n", numRequisicoes, tamanhoLote);
+    printf("Tempo total: %.3f s\n", duracao / 1e6);
+    printf("Vazao: %.0f requisicoes/s\n", duracao > 0 ? numRequisicoes * 1e6 / duracao : 0.0);
+    printf("Latencia por lote (us): p50=%lld p99=%lld p99.9=%lld max=%lld\n",
+           latencias[numLotes / 2],
+           latencias[(int)(numLotes * 0.99)],
+           latencias[(int)(numLotes * 0.999)],
+           latencias[numLotes - 1]);
+    
+    close(fd);
+    free(lote);
+    free(latencias);
+    free(recepcao);
+    return EXIT_SUCCESS;
+}
+
+#endif
+
+// ======== COMPARAÇÃO DO CACHE DE CHAVES QUENTES ========
+
+// Número aleatório de 30 bits (RAND_MAX pode ser apenas 32767)
+int aleatorioGrande() {
+    return ((rand() & 0x7FFF) << 15) | (rand() & 0x7FFF);
+}
+
+// Segundos decorridos desde 'inicio'
+double segundosDesde(clock_t inicio) {
+    return (double)(clock() - inicio) / CLOCKS_PER_SEC;
+}
+
+// Gerar consultas com distribuição Zipf sobre as chaves informadas
+void gerarConsultasZipf(int* consultas, int numConsultas, const int* chaves, int numChaves, double expoente) {
+    double* acumulada = (double*)malloc((size_t)numChaves * sizeof(double));
+    double soma = 0.0;
+    
+    if (acumulada == NULL) {
+        fprintf(stderr, "Erro na alocação de memória\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    for (int i = 0; i < numChaves; i++) {
+        soma += 1.0 / pow(i + 1, expoente);
+        acumulada[i] = soma;
+    }
+    
+    // Busca binária na distribuição acumulada
+    for (int q = 0; q < numConsultas; q++) {
+        double alvo = soma * aleatorioGrande() / (double)(1 << 30);
+        int ini = 0, fim = numChaves - 1;
+        while (ini < fim) {
+            int meio = ini + (fim - ini) / 2;
+            if (acumulada[meio] < alvo) {
+                ini = meio + 1;
+            } else {
+                fim = meio;
+            }
+        }
+        consultas[q] = chaves[ini];
+    }
+    
+    free(acumulada);
+}
+
+// Comparar buscas com e sem cache em BST, AVL e 2-3-4 sob carga Zipf
+int executarComparacaoCache(int numChaves, int numConsultas, double expoente) {
+    int* chaves = (int*)malloc((size_t)numChaves * sizeof(int));
+    int* consultas = (int*)malloc((size_t)numConsultas * sizeof(int));
+    NoBST* raizBST = NULL;
+    NoAVL* raizAVL = NULL;
+    No234* raiz234 = NULL;
+    No234* noEncontrado = NULL;
+    CacheQuente cache;
+    clock_t inicio;
+    double tempoSemCache, tempoComCache;
+    long encontrados = 0;
+    int posicao, i;
+    
+    if (chaves == NULL || consultas == NULL) {
+        fprintf(stderr, "Erro na alocação de memória\n");
+        exit(EXIT_FAILURE);
+    }
+    
+    // Chaves pares embaralhadas (evita BST degenerada); as mais
+    // frequentes da distribuição ficam espalhadas pela árvore
+    srand(42);
+    for (i = 0; i < numChaves; i++) {
+        chaves[i] = i * 2;
+    }
+    for (i = numChaves - 1; i > 0; i--) {
+        int j = aleatorioGrande() % (i + 1);
+        int temp = chaves[i];
+        chaves[i] = chaves[j];
+        chaves[j] = temp;
+    }
+    for (i = 0; i < numChaves; i++) {
+        raizBST = inserirBST(raizBST, chaves[i]);
+        raizAVL = inserirAVL(raizAVL, chaves[i]);
+        raiz234 = inserir234(raiz234, chaves[i]);
+    }
+    gerarConsultasZipf(consultas, numConsultas, chaves, numChaves, expoente);
+    
+    printf("Chaves: %d, consultas: %d, expoente Zipf: %.2f, cache: %d posicoes\n",
+           numChaves, numConsultas, expoente, TAMANHO_CACHE);
+    printf("%-8s %14s %14s %12s\n", "Arvore", "Sem cache (s)", "Com cache (s)", "Acertos (%)");
+    
+    inicio = clock();
+    for (i = 0; i < numConsultas; i++) {
+        encontrados += buscarBST(raizBST, consultas[i]) != NULL;
+    }
+    tempoSemCache = segundosDesde(inicio);
+    iniciarCache(&cache);
+    inicio = clock();
+    for (i = 0; i < numConsultas; i++) {
+        encontrados += buscarBSTComCache(&cache, raizBST, consultas[i]);
+    }
+    tempoComCache = segundosDesde(inicio);
+    printf("%-8s %14.3f %14.3f %12.2f\n", "BST", tempoSemCache, tempoComCache, taxaAcertosCache(&cache));
+    
+    inicio = clock();
+    for (i = 0; i < numConsultas; i++) {
+        encontrados += buscarAVL(raizAVL, consultas[i]) != NULL;
+    }
+    tempoSemCache = segundosDesde(inicio);
+    iniciarCache(&cache);
+    inicio = clock();
+    for (i = 0; i < numConsultas; i++) {
+        encontrados += buscarAVLComCache(&cache, raizAVL, consultas[i]);
+    }
+    tempoComCache = segundosDesde(inicio);
+    printf("%-8s %14.3f %14.3f %12.2f\n", "AVL", tempoSemCache, tempoComCache, taxaAcertosCache(&cache));
+    
+    inicio = clock();
+    for (i = 0; i < numConsultas; i++) {
+        encontrados += buscar234(raiz234, consultas[i], &noEncontrado, &posicao);
+    }
+    tempoSemCache = segundosDesde(inicio);
+    iniciarCache(&cache);
+    inicio = clock();
+    for (i = 0; i < numConsultas; i++) {
+        encontrados += buscar234ComCache(&cache, raiz234, consultas[i]);
+    }
+    tempoComCache = segundosDesde(inicio);
+    printf("%-8s %14.3f %14.3f %12.2f\n", "2-3-4", tempoSemCache, tempoComCache, taxaAcertosCache(&cache));
+    
+    // Todas as consultas são de chaves presentes
+    if (encontrados != 6L * numConsultas) {
+        fprintf(stderr, "Resultado inconsistente: %ld encontrados\n", encontrados);
+    }
+    
+    liberarBST(raizBST);
+    liberarAVL(raizAVL);
+    liberar234(raiz234);
+    free(chaves);
+    free(consultas);
+    return EXIT_SUCCESS;
+}
+
+// ======== FUNÇÃO MAIN ========
+
+int main(int argc, char* argv[]) {
+    int escolha, valor;
+    NoBST* raizBST = NULL;
+    NoAVL* raizAVL = NULL;
+    No234* raiz234 = NULL;
+    ControleRemocao controleBST, controleAVL;
+    CacheQuente cacheBST, cache234;
+    
+    iniciarControleRemocao(&controleBST);
+    iniciarControleRemocao(&controleAVL);
+    iniciarCache(&cacheBST);
+    iniciarCache(&cache234);
+    
+    // Comparação do cache: --bench-cache [chaves] [consultas] [expoente]
+    if (argc >= 2 && strcmp(argv[1], "--bench-cache") == 0) {
+        int numChaves = argc >= 3 ? atoi(argv[2]) : 1000000;
+        int numConsultas = argc >= 4 ? atoi(argv[3]) : 10000000;
+        double expoente = argc >= 5 ? atof(argv[4]) : 1.0;
+        if (numChaves <= 0 || numConsultas <= 0) {
+            fprintf(stderr, "Numero de chaves e de consultas devem ser positivos\n");
+            return EXIT_FAILURE;
+        }
+        return executarComparacaoCache(numChaves, numConsultas, expoente);
+    }
+    
+#ifdef __linux__
+    // Modos de linha de comando:
+    //   --servidor <socket>
+    //   --carga <socket> [requisicoes] [lote] [avl|234]
+    if (argc >= 3 && strcmp(argv[1], "--servidor") == 0) {
+        return executarServidor(argv[2]);
+    }
+    if (argc >= 3 && strcmp(argv[1], "--carga") == 0) {
+        int numRequisicoes = argc >= 4 ? atoi(argv[3]) : 1000000;
+        int tamanhoLote = argc >= 5 ? atoi(argv[4]) : 64;
+        int tipoArvore = (argc >= 6 && strcmp(argv[5], "234") == 0) ? ARVORE_234 : ARVORE_AVL;
+        if (numRequisicoes <= 0 || tamanhoLote <= 0) {
+            fprintf(stderr, "Numero de requisicoes e tamanho do lote devem ser positivos\n");
+            return EXIT_FAILURE;
+        }
+        return executarCarga(argv[2], numRequisicoes, tamanhoLote, tipoArvore);
+    }
+#endif
+    
+    do {
+        printf("\n==== MENU DE OPERACOES COM ARVORES ====\n");
+        printf("1. Arvore de Busca Binaria (BST)\n");
+        printf("2. Arvore AVL\n");
+        printf("3. Arvore 2-3-4\n");
+        printf("0. Sair\n");
+        printf("Escolha uma opcao: ");
+        scanf("%d", &escolha);
+        
+        switch (escolha) {
+            case 1: // BST
+                do {
+                    printf("\n--- Operacoes com BST ---\n");
+                    printf("1. Inserir valor\n");
+                    printf("2. Buscar valor\n");
+                    printf("3. Remover valor\n");
+                    printf("4. Exibir arvore\n");
+                    printf("5. Remover valor (preguicoso)\n");
+                    printf("6. Compactar remocoes pendentes\n");
+                    printf("7. Exportar arvore\n");
+                    printf("8. Estatisticas do cache de buscas\n");
+                    printf("0. Voltar\n");
+                    printf("Escolha uma opcao: ");
+                    scanf("%d", &escolha);
+                    
+                    switch (escolha) {
+                        case 1:
+                            printf("Digite o valor a inserir: ");
+                            scanf("%d", &valor);
+                            raizBST = inserirBSTControlado(raizBST, valor, &controleBST);
+                            printf("Valor %d inserido com sucesso!\n", valor);
+                            break;
+                        case 2:
+                            printf("Digite o valor a buscar: ");
+                            scanf("%d", &valor);
+                            if (buscarBSTComCache(&cacheBST, raizBST, valor)) {
+                                printf("Valor %d encontrado na arvore!\n", valor);
+                            } else {
+                                printf("Valor %d não encontrado na arvore.\n", valor);
+                            }
+                            break;
+                        case 3:
+                            printf("Digite o valor a remover: ");
+                            scanf("%d", &valor);
+                            invalidarCache(&cacheBST, valor);
+                            raizBST = removerBSTControlado(raizBST, valor, &controleBST);
+                            printf("Operacao de remocao concluida.\n");
+                            break;
+                        case 4:
+                            printf("\nExibicao da BST:\n");
+                            if (raizBST == NULL) {
+                                printf("Arvore vazia\n");
+                            } else {
+                                exibirBST(raizBST, 0);
+                            }
+                            break;
+                        case 5:
+                            printf("Digite o valor a remover: ");
+                            scanf("%d", &valor);
+                            invalidarCache(&cacheBST, valor);
+                            removerPreguicosoBST(raizBST, valor, &controleBST);
+                            printf("Nos marcados como removidos: %d de %d\n",
+                                   controleBST.numRemovidos, controleBST.numNos);
+                            if (deveCompactar(&controleBST)) {
+                                printf("Limiar atingido: recomenda-se compactar a arvore.\n");
+                            }
+                            break;
+                        case 6:
+                            while (controleBST.numPendentes > 0) {
+                                raizBST = compactarBST(raizBST, &controleBST, FATIA_COMPACTACAO);
+                            }
+                            printf("Compactacao concluida.\n");
+                            break;
+                        case 7: {
+                            OpcoesExportacao opcoes;
+                            FILE* arquivo = lerOpcoesExportacao(&opcoes);
+                            if (arquivo != NULL) {
+                                exportarBST(arquivo, raizBST, opcoes);
+                                if (arquivo != stdout) {
+                                    fclose(arquivo);
+                                }
+                            }
+                            break;
+                        }
+                        case 8:
+                            exibirEstatisticasCache(&cacheBST);
+                            break;
+                        case 0:
+                            break;
+                        default:
+                            printf("Opcao invalida!\n");
+                    }
+                } while (escolha != 0);
+                escolha = -1; // Retorna ao menu principal
+                break;
+                
+            case 2: // AVL
+                do {
+                    printf("\n--- Operacoes com AVL ---\n");
+                    printf("1. Inserir valor\n");
+                    printf("2. Remover valor\n");
+                    printf("3. Exibir arvore\n");
+                    printf("4. Remover valor (preguicoso)\n");
+                    printf("5. Compactar remocoes pendentes\n");
+                    printf("6. Exportar arvore\n");
+                    printf("0. Voltar\n");
                     printf("Escolha uma opcao: ");
                     scanf("%d", &escolha);
                     
@@ -646,13 +2458,13 @@ int main() {
                         case 1:
                             printf("Digite o valor a inserir: ");
                             scanf("%d", &valor);
-                            raizAVL = inserirAVL(raizAVL, valor);
+                            raizAVL = inserirAVLControlado(raizAVL, valor, &controleAVL);
                             printf("Valor %d inserido com sucesso!\n", valor);
                             break;
                         case 2:
                             printf("Digite o valor a remover: ");
                             scanf("%d", &valor);
-                            raizAVL = removerAVL(raizAVL, valor);
+                            raizAVL = removerAVLControlado(raizAVL, valor, &controleAVL);
                             printf("Operacao de remocao concluida.\n");
                             break;
                         case 3:
@@ -663,6 +2475,33 @@ int main() {
                                 exibirAVL(raizAVL, 0);
                             }
                             break;
+                        case 4:
+                            printf("Digite o valor a remover: ");
+                            scanf("%d", &valor);
+                            removerPreguicosoAVL(raizAVL, valor, &controleAVL);
+                            printf("Nos marcados como removidos: %d de %d\n",
+                                   controleAVL.numRemovidos, controleAVL.numNos);
+                            if (deveCompactar(&controleAVL)) {
+                                printf("Limiar atingido: recomenda-se compactar a arvore.\n");
+                            }
+                            break;
+                        case 5:
+                            while (controleAVL.numPendentes > 0) {
+                                raizAVL = compactarAVL(raizAVL, &controleAVL, FATIA_COMPACTACAO);
+                            }
+                            printf("Compactacao concluida.\n");
+                            break;
+                        case 6: {
+                            OpcoesExportacao opcoes;
+                            FILE* arquivo = lerOpcoesExportacao(&opcoes);
+                            if (arquivo != NULL) {
+                                exportarAVL(arquivo, raizAVL, opcoes);
+                                if (arquivo != stdout) {
+                                    fclose(arquivo);
+                                }
+                            }
+                            break;
+                        }
                         case 0:
                             break;
                         default:
@@ -678,6 +2517,8 @@ int main() {
                     printf("1. Inserir valor\n");
                     printf("2. Buscar valor\n");
                     printf("3. Exibir arvore\n");
+                    printf("4. Exportar arvore\n");
+                    printf("5. Estatisticas do cache de buscas\n");
                     printf("0. Voltar\n");
                     printf("Escolha uma opcao: ");
                     scanf("%d", &escolha);
@@ -689,18 +2530,15 @@ int main() {
                             raiz234 = inserir234(raiz234, valor);
                             printf("Valor %d inserido com sucesso!\n", valor);
                             break;
-                        case 2: {
+                        case 2:
                             printf("Digite o valor a buscar: ");
                             scanf("%d", &valor);
-                            No234* noEncontrado = NULL;
-                            int posicao = -1;
-                            if (buscar234(raiz234, valor, &noEncontrado, &posicao)) {
+                            if (buscar234ComCache(&cache234, raiz234, valor)) {
                                 printf("Valor %d encontrado na arvore!\n", valor);
                             } else {
                                 printf("Valor %d não encontrado na arvore.\n", valor);
                             }
                             break;
-                        }
                         case 3:
                             printf("\nExibicao da arvore 2-3-4:\n");
                             if (raiz234 == NULL) {
@@ -709,6 +2547,20 @@ int main() {
                                 exibir234(raiz234, 0);
                             }
                             break;
+                        case 4: {
+                            OpcoesExportacao opcoes;
+                            FILE* arquivo = lerOpcoesExportacao(&opcoes);
+                            if (arquivo != NULL) {
+                                exportar234(arquivo, raiz234, opcoes);
+                                if (arquivo != stdout) {
+                                    fclose(arquivo);
+                                }
+                            }
+                            break;
+                        }
+                        case 5:
+                            exibirEstatisticasCache(&cache234);
+                            break;
                         case 0:
                             break;
                         default:
@@ -724,6 +2576,8 @@ int main() {
                 liberarBST(raizBST);
                 liberarAVL(raizAVL);
                 liberar234(raiz234);
+                liberarControleRemocao(&controleBST);
+                liberarControleRemocao(&controleAVL);
                 break;
                 
             default: